@@ -1,4 +1,6 @@
 #include "BMP.h"
+#include "Numa.h"
+#include "Profile.h"
 #include <array>
 #include <exception>
 #include <stdexcept>
@@ -68,30 +70,42 @@ ColourRow::ColourRow(size_t width) {
     padding = (4 - (3 * static_cast<int>(width)) % 4) % 4;
 }
 
+// Colour is stored exactly as in the file (blue, green, red without padding), so a row is read and written at once
+static_assert(sizeof(Colour) == 3);
+
 void ColourRow::Read(std::ifstream &input_file) {
-    for (auto& colour : colours) {
-        colour.Read(input_file);
-    }
-    for (int i = 0; i < padding; ++i) {
-        input_file.ignore(1);
-    }
+    input_file.read(reinterpret_cast<char *>(colours.data()), static_cast<std::streamsize>(3 * colours.size()));
+    input_file.ignore(padding);
 }
 
 void ColourRow::Write(std::ofstream &output_file, int width) {
-    for (auto& colour: colours) {
-        colour.Write(output_file);
-    }
+    output_file.write(reinterpret_cast<const char *>(colours.data()), static_cast<std::streamsize>(3 * colours.size()));
     padding = (4 - (3 * width) % 4) % 4;
     int32_t writing_colour = 0;
     for (int i = 0; i < padding; ++i) {
-        output_file.write(reinterpret_cast<const char*>(writing_colour), 1);
+        output_file.write(reinterpret_cast<const char*>(&writing_colour), 1);
     }
 }
 
 void PixelArray::Make(int height, int width) {
     rows_number = static_cast<size_t>(std::abs(height));
     rows_size = static_cast<size_t>(width);
-    rows.assign(rows_number, ColourRow(width));
+    rows = MakeRows(rows_number, rows_size, Schedule());
+}
+
+// In NUMA mode every row is allocated and first touched by the worker that processes it with this schedule,
+// so its pages end up on that worker's node
+std::vector<ColourRow> PixelArray::MakeRows(size_t rows_number, size_t width, const Schedule& schedule) {
+    if (!Numa::enabled) {
+        return std::vector<ColourRow>(rows_number, ColourRow(width));
+    }
+    std::vector<ColourRow> rows(rows_number, ColourRow(0));
+    Parallel::ForEachBand(rows_number, schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            rows[i] = ColourRow(width);
+        }
+    });
+    return rows;
 }
 
 void PixelArray::Read(std::ifstream &input_file) {
@@ -101,7 +115,7 @@ void PixelArray::Read(std::ifstream &input_file) {
 }
 
 void PixelArray::Write(std::ofstream &output_file) {
-    for (ColourRow colour_row: rows) {
+    for (ColourRow& colour_row: rows) {
         colour_row.Write(output_file, static_cast<int>(rows_size));
     }
 }
@@ -138,6 +152,61 @@ void BMP::Write(const std::string& output_file_name) {
     }
 }
 
+// Overwrites only the pixels of dirty tiles in a file previously written by BMP::Write with the same size
+void BMP::WriteTiles(const std::string& output_file_name, const TileMap& tiles) {
+    std::fstream output_file(output_file_name, std::ios::in | std::ios::out | std::ios::binary);
+    if (!output_file.is_open()) {
+        throw std::invalid_argument("Not valid path to output file: " + output_file_name);
+    }
+    size_t row_bytes = 3 * pixel_array.rows_size + (4 - (3 * pixel_array.rows_size) % 4) % 4;
+    for (size_t tile_row = 0; tile_row < tiles.tile_rows; ++tile_row) {
+        for (auto [first, last] : tiles.DirtyRuns(tile_row)) {
+            size_t col_begin = tiles.ColBegin(first);
+            size_t col_end = tiles.ColEnd(last - 1);
+            for (size_t i = tiles.RowBegin(tile_row); i < tiles.RowEnd(tile_row); ++i) {
+                output_file.seekp(static_cast<std::streamoff>(PIXELS_OFFSET + i * row_bytes + 3 * col_begin));
+                output_file.write(reinterpret_cast<const char *>(pixel_array.rows[i].colours.data() + col_begin),
+                                  static_cast<std::streamsize>(3 * (col_end - col_begin)));
+            }
+        }
+    }
+    output_file.close();
+}
+
+// 64-bit FNV-1a hash of every tile, row by row
+std::vector<uint64_t> BMP::TileHashes(const TileMap& tiles) const {
+    std::vector<uint64_t> hashes(tiles.tile_rows * tiles.tile_cols, 14695981039346656037ull);
+    for (size_t tile_row = 0; tile_row < tiles.tile_rows; ++tile_row) {
+        for (size_t i = tiles.RowBegin(tile_row); i < tiles.RowEnd(tile_row); ++i) {
+            const auto* bytes = reinterpret_cast<const uint8_t *>(pixel_array.rows[i].colours.data());
+            for (size_t tile_col = 0; tile_col < tiles.tile_cols; ++tile_col) {
+                uint64_t& hash = hashes[tile_row * tiles.tile_cols + tile_col];
+                for (size_t k = 3 * tiles.ColBegin(tile_col); k < 3 * tiles.ColEnd(tile_col); ++k) {
+                    hash = (hash ^ bytes[k]) * 1099511628211ull;
+                }
+            }
+        }
+    }
+    return hashes;
+}
+
+// Copies rows [row_begin, row_end) and columns [col_begin, col_end) to a separate image
+BMP BMP::Extract(size_t row_begin, size_t row_end, size_t col_begin, size_t col_end) const {
+    BMP window;
+    window.header = header;
+    window.dib = dib;
+    window.dib.width = window.width = static_cast<int>(col_end - col_begin);
+    window.dib.height = window.height = static_cast<int>(row_end - row_begin);
+    window.RenewSize();
+    window.pixel_array.Make(window.height, window.width);
+    for (size_t i = row_begin; i < row_end; ++i) {
+        const auto& colours = pixel_array.rows[i].colours;
+        std::copy(colours.begin() + col_begin, colours.begin() + col_end,
+                  window.pixel_array.rows[i - row_begin].colours.begin());
+    }
+    return window;
+}
+
 void BMP::SetHeight(int new_height) {
     for (size_t i = new_height; i < height; ++i) {
         pixel_array.rows.pop_back();
@@ -160,28 +229,43 @@ void BMP::SetWidth(int new_width) {
     RenewSize();
 }
 
+const std::array<std::array<int, 3>, 3> MATRIX_DELTA_X = {{{{-1, 0, 1}},
+                                                           {{-1, 0, 1}},
+                                                           {{-1, 0, 1}}}};
+const std::array<std::array<int, 3>, 3> MATRIX_DELTA_Y = {{{{-1 - 1, -1}},
+                                                           {{0, 0, 0}},
+                                                           {{1, 1, 1}}}};
+
+size_t BMP::PixelsNumber() const {
+    return pixel_array.rows_number * pixel_array.rows_size;
+}
+
+size_t BMP::NeighbourRow(size_t i, int delta) const {
+    size_t needed_row = 0;
+    if (0 <= i + delta && i + delta < height) {
+        needed_row = i + delta;
+    } else if (height <= i + delta) {
+        needed_row = height - 1;
+    }
+    return needed_row;
+}
+
+size_t BMP::NeighbourCol(size_t j, int delta) const {
+    size_t needed_col = 0;
+    if (0 <= j + delta && j + delta < width) {
+        needed_col = j + delta;
+    } else if (width >= j + delta) {
+        needed_col = width - 1;
+    }
+    return needed_col;
+}
+
 Colour BMP::CountNewColour(const std::array<std::array<int, 3>, 3>& matrix, size_t i, size_t j) {
     std::array<int, 3> result_int = {0, 0, 0};
-    std::array<std::array<int, 3>, 3> delta_x = {{{{-1, 0, 1}},
-                                                 {{-1, 0, 1}},
-                                                 {{-1, 0, 1}}}};
-    std::array<std::array<int, 3>, 3> delta_y = {{{{-1 - 1, -1}},
-                                                 {{0, 0, 0}},
-                                                  {{1, 1, 1}}}};
     for (size_t k = 0; k < 3; ++k) {
         for (size_t t = 0; t < 3; ++t) {
-            size_t needed_row = 0;
-            size_t needed_col = 0;
-            if (0 <= i + delta_y[k][t] && i + delta_y[k][t] < height) {
-                needed_row = i + delta_y[k][t];
-            } else if (height <= i + delta_y[k][t]) {
-                needed_row = height - 1;
-            }
-            if (0 <= j + delta_x[k][t] && j + delta_x[k][t] < width) {
-                needed_col = j + delta_x[k][t];
-            } else if (width >= j + delta_x[k][t]) {
-                needed_col = width - 1;
-            }
+            size_t needed_row = NeighbourRow(i, MATRIX_DELTA_Y[k][t]);
+            size_t needed_col = NeighbourCol(j, MATRIX_DELTA_X[k][t]);
             result_int[0] += matrix[k][t] * pixel_array.rows[needed_row].colours[needed_col].blue;
             result_int[1] += matrix[k][t] * pixel_array.rows[needed_row].colours[needed_col].green;
             result_int[2] += matrix[k][t] * pixel_array.rows[needed_row].colours[needed_col].red;
@@ -195,29 +279,104 @@ Colour BMP::CountNewColour(const std::array<std::array<int, 3>, 3>& matrix, size
 }
 
 void BMP::ApplyMatrix(const std::array<std::array<int, 3>, 3> &matrix) {
-    std::vector<ColourRow> new_rows(pixel_array.rows_number, ColourRow(pixel_array.rows_size));
-    for (size_t i = 0; i < pixel_array.rows_number; ++i) {
-        for (size_t j = 0; j < pixel_array.rows_size; ++j) {
-            new_rows[i].colours[j] = CountNewColour(matrix, i, j);
+    ApplyMatrix(matrix, Profile::Active().Choose("matrix", PixelsNumber()));
+}
+
+void BMP::ApplyMatrix(const std::array<std::array<int, 3>, 3> &matrix, const KernelChoice& choice) {
+    if (choice.variant == "direct") {
+        ApplyMatrixDirect(matrix, choice.schedule);
+    } else {
+        ApplyMatrixIndexed(matrix, choice.schedule);
+    }
+}
+
+void BMP::ApplyMatrixDirect(const std::array<std::array<int, 3>, 3> &matrix, const Schedule& schedule) {
+    std::vector<ColourRow> new_rows =
+        PixelArray::MakeRows(pixel_array.rows_number, pixel_array.rows_size, schedule);
+    Parallel::ForEachBand(pixel_array.rows_number, schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t j = 0; j < pixel_array.rows_size; ++j) {
+                new_rows[i].colours[j] = CountNewColour(matrix, i, j);
+            }
+        }
+    });
+    pixel_array.rows = std::move(new_rows);
+}
+
+// Same result as ApplyMatrixDirect, but neighbour indices are resolved once per row and per column
+// instead of once per pixel, and zero coefficients are skipped
+void BMP::ApplyMatrixIndexed(const std::array<std::array<int, 3>, 3> &matrix, const Schedule& schedule) {
+    std::vector<std::array<std::array<size_t, 3>, 3>> neighbour_cols(pixel_array.rows_size);
+    for (size_t j = 0; j < pixel_array.rows_size; ++j) {
+        for (size_t k = 0; k < 3; ++k) {
+            for (size_t t = 0; t < 3; ++t) {
+                neighbour_cols[j][k][t] = NeighbourCol(j, MATRIX_DELTA_X[k][t]);
+            }
         }
     }
+    std::vector<ColourRow> new_rows =
+        PixelArray::MakeRows(pixel_array.rows_number, pixel_array.rows_size, schedule);
+    Parallel::ForEachBand(pixel_array.rows_number, schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            std::array<std::array<const Colour*, 3>, 3> neighbour_rows = {};
+            for (size_t k = 0; k < 3; ++k) {
+                for (size_t t = 0; t < 3; ++t) {
+                    neighbour_rows[k][t] = pixel_array.rows[NeighbourRow(i, MATRIX_DELTA_Y[k][t])].colours.data();
+                }
+            }
+            for (size_t j = 0; j < pixel_array.rows_size; ++j) {
+                std::array<int, 3> result_int = {0, 0, 0};
+                for (size_t k = 0; k < 3; ++k) {
+                    for (size_t t = 0; t < 3; ++t) {
+                        if (matrix[k][t] == 0) {
+                            continue;
+                        }
+                        const Colour& colour = neighbour_rows[k][t][neighbour_cols[j][k][t]];
+                        result_int[0] += matrix[k][t] * colour.blue;
+                        result_int[1] += matrix[k][t] * colour.green;
+                        result_int[2] += matrix[k][t] * colour.red;
+                    }
+                }
+                Colour& new_colour = new_rows[i].colours[j];
+                new_colour.blue = static_cast<uint8_t>(std::max(0, std::min(255, result_int[0])));
+                new_colour.green = static_cast<uint8_t>(std::max(0, std::min(255, result_int[1])));
+                new_colour.red = static_cast<uint8_t>(std::max(0, std::min(255, result_int[2])));
+            }
+        }
+    });
     pixel_array.rows = std::move(new_rows);
 }
 
+void BMP::ApplyLut(const ChannelLut& lut) {
+    ApplyLut(lut, Profile::Active().Choose("point", PixelsNumber()).schedule);
+}
+
+void BMP::ApplyLut(const ChannelLut& lut, const Schedule& schedule) {
+    Parallel::ForEachBand(pixel_array.rows_number, schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (auto& colour : pixel_array.rows[i].colours) {
+                colour.blue = lut[0][colour.blue];
+                colour.green = lut[1][colour.green];
+                colour.red = lut[2][colour.red];
+            }
+        }
+    });
+}
+
 Colour BMP::CountVertical(size_t sigma, size_t x0, size_t y0, double pi_constant, double exp_constant) {
     size_t min_y = std::max(static_cast<size_t>(0), y0 - 3 * sigma);
     size_t max_y = std::min(static_cast<size_t>(height) - 1, y0 + 3 * sigma);
     std::array<int, 3> result_int = {0, 0, 0};
     double koef_sum = 0;
     for (size_t i = min_y; i < y0; ++i) {
-        double constant = pi_constant * std::powl(exp_constant, (y0 - i) * (y0 - i));
+        double constant = pi_constant * powl(exp_constant, (y0 - i) * (y0 - i));
         koef_sum += constant;
         result_int[0] += pixel_array.rows[i].colours[x0].blue * constant;
         result_int[1] += pixel_array.rows[i].colours[x0].green * constant;
         result_int[2] += pixel_array.rows[i].colours[x0].red * constant;
     }
     for (size_t i = y0; i < max_y; ++i) {
-        double constant = pi_constant * std::powl(exp_constant, (i - y0) * (i - y0));
+        double constant = pi_constant * powl(exp_constant, (i - y0) * (i - y0));
         koef_sum += constant;
         result_int[0] += pixel_array.rows[i].colours[x0].blue * constant;
         result_int[1] += pixel_array.rows[i].colours[x0].green * constant;
@@ -236,14 +395,14 @@ Colour BMP::CountHorizontal(size_t sigma, size_t x0, size_t y0, double pi_consta
     std::array<int, 3> result_int = {0, 0, 0};
     double koef_sum = 0;
     for (size_t i = min_x; i < x0; ++i) {
-        double constant = pi_constant * std::powl(exp_constant, (x0 - i) * (x0 - i));
+        double constant = pi_constant * powl(exp_constant, (x0 - i) * (x0 - i));
         koef_sum += constant;
         result_int[0] += pixel_array.rows[y0].colours[i].blue * constant;
         result_int[1] += pixel_array.rows[y0].colours[i].green * constant;
         result_int[2] += pixel_array.rows[y0].colours[i].red * constant;
     }
     for (size_t i = x0; i < max_x; ++i) {
-        double constant = pi_constant * std::powl(exp_constant, (i - x0) * (i - x0));
+        double constant = pi_constant * powl(exp_constant, (i - x0) * (i - x0));
         koef_sum += constant;
         result_int[0] += pixel_array.rows[y0].colours[i].blue * constant;
         result_int[1] += pixel_array.rows[y0].colours[i].green * constant;
@@ -6,6 +6,10 @@
 #include <vector>
 #include <fstream>
 #include <array>
+#include <cstdint>
+#include <string>
+#include "Profile.h"
+#include "TileMap.h"
 
 class Header {
 public:
@@ -61,13 +65,18 @@ public:
     size_t rows_number = 0;
     size_t rows_size = 0;
     void Make(int height, int width);
+    static std::vector<ColourRow> MakeRows(size_t rows_number, size_t width, const Schedule& schedule);
 
     void Read(std::ifstream& input_file);
     void Write(std::ofstream& output_file);
 };
 
+using ChannelLut = std::array<std::array<uint8_t, 256>, 3>;
+
 class BMP {
 public:
+    static const size_t PIXELS_OFFSET = 54;
+
     Header header;
     DIB dib;
     PixelArray pixel_array;
@@ -77,11 +86,22 @@ public:
 
     void Read(const std::string& input_file_name);
     void Write(const std::string& output_file_name);
+    void WriteTiles(const std::string& output_file_name, const TileMap& tiles);
+    std::vector<uint64_t> TileHashes(const TileMap& tiles) const;
+    BMP Extract(size_t row_begin, size_t row_end, size_t col_begin, size_t col_end) const;
     void SetHeight(int new_height);
     void SetWidth(int new_width);
     void RenewSize();
+    size_t PixelsNumber() const;
+    size_t NeighbourRow(size_t i, int delta) const;
+    size_t NeighbourCol(size_t j, int delta) const;
     Colour CountNewColour(const std::array<std::array<int, 3>, 3>& matrix, size_t i, size_t j);
     void ApplyMatrix(const std::array<std::array<int, 3>, 3>& matrix);
+    void ApplyMatrix(const std::array<std::array<int, 3>, 3>& matrix, const KernelChoice& choice);
+    void ApplyMatrixDirect(const std::array<std::array<int, 3>, 3>& matrix, const Schedule& schedule);
+    void ApplyMatrixIndexed(const std::array<std::array<int, 3>, 3>& matrix, const Schedule& schedule);
+    void ApplyLut(const ChannelLut& lut);
+    void ApplyLut(const ChannelLut& lut, const Schedule& schedule);
     Colour CountVertical(size_t sigma, size_t x0, size_t y0, double pi_constant, double exp_constant);
     Colour CountHorizontal(size_t sigma, size_t x0, size_t y0, double pi_constant, double exp_constant);
 };
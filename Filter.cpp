@@ -1,4 +1,5 @@
 #include "Filter.h"
+#include "Histogram.h"
 #include <iostream>
 #include <cmath>
 
@@ -8,6 +9,78 @@ Filter::Filter(const std::vector<int>& params) {
     this->params = params;
 }
 
+// Distance in pixels from which an input pixel can affect an output pixel
+size_t Filter::Footprint() const {
+    return 0;
+}
+
+// Whether the top rows of the output also depend on the bottom row of the input, as in BMP::ApplyMatrix
+bool Filter::WrapsRows() const {
+    return false;
+}
+
+// Whether every output pixel depends on the whole input
+bool Filter::IsGlobal() const {
+    return false;
+}
+
+TileMap Filter::DirtyTiles(const TileMap& input_tiles) const {
+    if (!input_tiles.Any()) {
+        return input_tiles;
+    }
+    TileMap output_tiles = input_tiles.Grow(Footprint());
+    if (IsGlobal()) {
+        output_tiles.MarkAll();
+    }
+    if (WrapsRows() && output_tiles.tile_rows > 0) {
+        for (size_t tile_col = 0; tile_col < output_tiles.tile_cols; ++tile_col) {
+            if (output_tiles.IsDirty(output_tiles.tile_rows - 1, tile_col)) {
+                output_tiles.Mark(0, tile_col);
+            }
+        }
+    }
+    return output_tiles;
+}
+
+// Recomputes the dirty tiles of output from input. Every run of dirty tiles is filtered as a separate window
+// with a margin of Footprint() + 1 pixels, enough for the window border not to affect the run itself
+void Filter::ApplyIncremental(const BMP& input, BMP& output, const TileMap& output_tiles) {
+    if (!output_tiles.Any()) {
+        return;
+    }
+    if (IsGlobal()) {
+        output = input;
+        ApplyFilter(output);
+        return;
+    }
+    size_t margin = Footprint() == 0 ? 0 : Footprint() + 1;
+    size_t rows_number = input.pixel_array.rows_number;
+    size_t rows_size = input.pixel_array.rows_size;
+    for (size_t tile_row = 0; tile_row < output_tiles.tile_rows; ++tile_row) {
+        for (auto [first, last] : output_tiles.DirtyRuns(tile_row)) {
+            size_t row_begin = output_tiles.RowBegin(tile_row);
+            size_t row_end = output_tiles.RowEnd(tile_row);
+            size_t col_begin = output_tiles.ColBegin(first);
+            size_t col_end = output_tiles.ColEnd(last - 1);
+            size_t window_row_begin = row_begin >= margin ? row_begin - margin : 0;
+            size_t window_row_end = std::min(rows_number, row_end + margin);
+            size_t window_col_begin = col_begin >= margin ? col_begin - margin : 0;
+            size_t window_col_end = std::min(rows_size, col_end + margin);
+            if (WrapsRows() && window_row_begin == 0) {
+                window_row_end = rows_number;
+            }
+            BMP window = input.Extract(window_row_begin, window_row_end, window_col_begin, window_col_end);
+            ApplyFilter(window);
+            for (size_t i = row_begin; i < row_end; ++i) {
+                const auto& colours = window.pixel_array.rows[i - window_row_begin].colours;
+                std::copy(colours.begin() + (col_begin - window_col_begin),
+                          colours.begin() + (col_end - window_col_begin),
+                          output.pixel_array.rows[i].colours.begin() + col_begin);
+            }
+        }
+    }
+}
+
 Crop::Crop(const std::vector<int>& params) : Filter(params) {
     this->params = params;
 }
@@ -22,19 +95,50 @@ void Crop::ApplyFilter(BMP& image) {
     image.SetWidth(new_width);
 }
 
+TileMap Crop::DirtyTiles(const TileMap& input_tiles) const {
+    return input_tiles.Resize(std::min(input_tiles.rows_number, static_cast<size_t>(params[1])),
+                              std::min(input_tiles.rows_size, static_cast<size_t>(params[0])));
+}
+
+void Crop::ApplyIncremental(const BMP& input, BMP& output, const TileMap& output_tiles) {
+    for (size_t tile_row = 0; tile_row < output_tiles.tile_rows; ++tile_row) {
+        for (auto [first, last] : output_tiles.DirtyRuns(tile_row)) {
+            for (size_t i = output_tiles.RowBegin(tile_row); i < output_tiles.RowEnd(tile_row); ++i) {
+                const auto& colours = input.pixel_array.rows[i].colours;
+                std::copy(colours.begin() + output_tiles.ColBegin(first),
+                          colours.begin() + output_tiles.ColEnd(last - 1),
+                          output.pixel_array.rows[i].colours.begin() + output_tiles.ColBegin(first));
+            }
+        }
+    }
+}
+
 Gs::Gs(const std::vector<int>& params) : Filter(params) {
     this->params = params;
 }
 
 void Gs::ApplyFilter(BMP& image) {
-    for (auto &row: image.pixel_array.rows) {
-        for (auto &colour: row.colours) {
-            int red = colour.red;
-            int green = colour.green;
-            int blue = colour.blue;
-            colour.blue = colour.green = colour.red = static_cast<int>(0.299 * red + 0.587 * green + 0.114 * blue);
+    ApplyFilter(image, Profile::Active().Choose("point", image.PixelsNumber()));
+}
+
+void Gs::ApplyFilter(BMP& image, const KernelChoice& choice) {
+    bool direct = choice.variant == "direct";
+    auto& rows = image.pixel_array.rows;
+    Parallel::ForEachBand(rows.size(), choice.schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (auto &colour: rows[i].colours) {
+                if (direct) {
+                    int red = colour.red;
+                    int green = colour.green;
+                    int blue = colour.blue;
+                    colour.blue = colour.green = colour.red =
+                        static_cast<int>(0.299 * red + 0.587 * green + 0.114 * blue);
+                } else {
+                    colour.blue = colour.green = colour.red = Histogram::Luma(colour);
+                }
+            }
         }
-    }
+    });
 }
 
 Neg::Neg(const std::vector<int>& params) : Filter(params) {
@@ -42,13 +146,28 @@ Neg::Neg(const std::vector<int>& params) : Filter(params) {
 }
 
 void Neg::ApplyFilter(BMP& image) {
-    for (auto &row: image.pixel_array.rows) {
-        for (auto &colour: row.colours) {
-            colour.blue = 255 - colour.blue;
-            colour.green = 255 - colour.green;
-            colour.red = 255 - colour.red;
+    ApplyFilter(image, Profile::Active().Choose("point", image.PixelsNumber()));
+}
+
+void Neg::ApplyFilter(BMP& image, const KernelChoice& choice) {
+    if (choice.variant != "direct") {
+        ChannelLut lut = {};
+        for (size_t value = 0; value < 256; ++value) {
+            lut[0][value] = lut[1][value] = lut[2][value] = static_cast<uint8_t>(255 - value);
         }
+        image.ApplyLut(lut, choice.schedule);
+        return;
     }
+    auto& rows = image.pixel_array.rows;
+    Parallel::ForEachBand(rows.size(), choice.schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (auto &colour: rows[i].colours) {
+                colour.blue = 255 - colour.blue;
+                colour.green = 255 - colour.green;
+                colour.red = 255 - colour.red;
+            }
+        }
+    });
 }
 
 Sharp::Sharp(const std::vector<int>& params) : Filter(params) {
@@ -56,10 +175,22 @@ Sharp::Sharp(const std::vector<int>& params) : Filter(params) {
 }
 
 void Sharp::ApplyFilter(BMP& image) {
+    ApplyFilter(image, Profile::Active().Choose("matrix", image.PixelsNumber()));
+}
+
+void Sharp::ApplyFilter(BMP& image, const KernelChoice& choice) {
     std::array<std::array<int, 3>, 3> matrix = {{{{0,  -1, 0}},
                                                  {{-1, 5,  -1}},
                                                  {{0,  -1, 0}}}};
-    image.ApplyMatrix(matrix);
+    image.ApplyMatrix(matrix, choice);
+}
+
+size_t Sharp::Footprint() const {
+    return 2;
+}
+
+bool Sharp::WrapsRows() const {
+    return true;
 }
 
 Edge::Edge(const std::vector<int>& params) : Filter(params) {
@@ -87,27 +218,128 @@ void Edge::ApplyFilter(BMP& image) {
     }
 }
 
+size_t Edge::Footprint() const {
+    return 2;
+}
+
+bool Edge::WrapsRows() const {
+    return true;
+}
+
 Blur::Blur(const std::vector<int>& params) : Filter(params) {
     this->params = params;
 }
 
 void Blur::ApplyFilter(BMP& image) {
+    ApplyFilter(image, Profile::Active().Choose("blur", image.PixelsNumber()));
+}
+
+void Blur::ApplyFilter(BMP& image, const KernelChoice& choice) {
+    if (choice.variant == "direct") {
+        ApplyDirect(image, choice.schedule);
+    } else {
+        ApplyTable(image, choice.schedule);
+    }
+}
+
+size_t Blur::Footprint() const {
+    return 3 * static_cast<size_t>(params[0]);
+}
+
+void Blur::ApplyDirect(BMP& image, const Schedule& schedule) {
     int sigma = params[0];
     double pi_constant = 1.0 / sqrt((2 * pi) * sigma);
     double exp_constant = std::exp(-1.0 / (2 * sigma * sigma));
-    std::vector<ColourRow> new_rows(image.pixel_array.rows_number, ColourRow(image.pixel_array.rows_size));
-    for (size_t i = 0; i < image.height; ++i) {
-        for (size_t j = 0; j < image.width; ++j) {
-            new_rows[i].colours[j] = image.CountVertical(sigma, j, i, pi_constant, exp_constant);
+    std::vector<ColourRow> new_rows =
+        PixelArray::MakeRows(image.pixel_array.rows_number, image.pixel_array.rows_size, schedule);
+    Parallel::ForEachBand(image.height, schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t j = 0; j < image.width; ++j) {
+                new_rows[i].colours[j] = image.CountVertical(sigma, j, i, pi_constant, exp_constant);
+            }
         }
-    }
+    });
     image.pixel_array.rows = std::move(new_rows);
-    std::vector<ColourRow> new_rows1(image.pixel_array.rows_number, ColourRow(image.pixel_array.rows_size));
-    for (size_t i = 0; i < image.height; ++i) {
-        for (size_t j = 0; j < image.width; ++j) {
-            new_rows1[i].colours[j] = image.CountHorizontal(sigma, j, i, pi_constant, exp_constant);
+    std::vector<ColourRow> new_rows1 =
+        PixelArray::MakeRows(image.pixel_array.rows_number, image.pixel_array.rows_size, schedule);
+    Parallel::ForEachBand(image.height, schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t j = 0; j < image.width; ++j) {
+                new_rows1[i].colours[j] = image.CountHorizontal(sigma, j, i, pi_constant, exp_constant);
+            }
         }
+    });
+    image.pixel_array.rows = std::move(new_rows1);
+}
+
+// Same result as ApplyDirect: weights are computed once per distance instead of once per pixel, and the vertical
+// pass accumulates whole rows at a time. Like BMP::CountVertical, taps above the image are dropped, not clamped
+void Blur::ApplyTable(BMP& image, const Schedule& schedule) {
+    size_t sigma = params[0];
+    double pi_constant = 1.0 / sqrt((2 * pi) * params[0]);
+    double exp_constant = std::exp(-1.0 / (2 * params[0] * params[0]));
+    size_t radius = 3 * sigma;
+    std::vector<double> weights(radius + 1);
+    for (size_t distance = 0; distance <= radius; ++distance) {
+        weights[distance] = pi_constant * powl(exp_constant, distance * distance);
     }
+    size_t height = image.height;
+    size_t width = image.width;
+    auto to_colour = [](const std::array<int, 3>& result_int, double koef_sum) {
+        std::array<uint8_t, 3> result_uint8_t = {0, 0, 0};
+        for (size_t k = 0; k < 3; ++k) {
+            result_uint8_t[k] = static_cast<uint8_t>(std::max(0.0, std::min(255.0, result_int[k] / koef_sum)));
+        }
+        return Colour(result_uint8_t);
+    };
+
+    std::vector<ColourRow> new_rows =
+        PixelArray::MakeRows(image.pixel_array.rows_number, image.pixel_array.rows_size, schedule);
+    Parallel::ForEachBand(height, schedule, [&](size_t worker, size_t begin, size_t end) {
+        std::vector<std::array<int, 3>> result_int(width);
+        for (size_t y0 = begin; y0 < end; ++y0) {
+            size_t min_y = y0 >= radius ? y0 - radius : y0;
+            size_t max_y = std::min(height - 1, y0 + radius);
+            std::fill(result_int.begin(), result_int.end(), std::array<int, 3>{0, 0, 0});
+            double koef_sum = 0;
+            for (size_t i = min_y; i < max_y; ++i) {
+                double constant = weights[i < y0 ? y0 - i : i - y0];
+                koef_sum += constant;
+                const auto& colours = image.pixel_array.rows[i].colours;
+                for (size_t x = 0; x < width; ++x) {
+                    result_int[x][0] += colours[x].blue * constant;
+                    result_int[x][1] += colours[x].green * constant;
+                    result_int[x][2] += colours[x].red * constant;
+                }
+            }
+            for (size_t x = 0; x < width; ++x) {
+                new_rows[y0].colours[x] = to_colour(result_int[x], koef_sum);
+            }
+        }
+    });
+    image.pixel_array.rows = std::move(new_rows);
+
+    std::vector<ColourRow> new_rows1 =
+        PixelArray::MakeRows(image.pixel_array.rows_number, image.pixel_array.rows_size, schedule);
+    Parallel::ForEachBand(height, schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t y0 = begin; y0 < end; ++y0) {
+            const auto& colours = image.pixel_array.rows[y0].colours;
+            for (size_t x0 = 0; x0 < width; ++x0) {
+                size_t min_x = x0 >= radius ? x0 - radius : x0;
+                size_t max_x = std::min(width - 1, x0 + radius);
+                std::array<int, 3> result_int = {0, 0, 0};
+                double koef_sum = 0;
+                for (size_t i = min_x; i < max_x; ++i) {
+                    double constant = weights[i < x0 ? x0 - i : i - x0];
+                    koef_sum += constant;
+                    result_int[0] += colours[i].blue * constant;
+                    result_int[1] += colours[i].green * constant;
+                    result_int[2] += colours[i].red * constant;
+                }
+                new_rows1[y0].colours[x0] = to_colour(result_int, koef_sum);
+            }
+        }
+    });
     image.pixel_array.rows = std::move(new_rows1);
 }
 
@@ -116,11 +348,93 @@ Acos::Acos(const std::vector<int>& params) : Filter(params) {
 }
 
 void Acos::ApplyFilter(BMP& image) {
-    for (auto &row: image.pixel_array.rows) {
-        for (auto &colour: row.colours) {
-            colour.blue = acos(colour.blue / 255.0) * 255;
-            colour.green = acos(colour.green / 255.0) * 255;
-            colour.red = acos(colour.green / 255.0) * 255;
+    ApplyFilter(image, Profile::Active().Choose("point", image.PixelsNumber()));
+}
+
+void Acos::ApplyFilter(BMP& image, const KernelChoice& choice) {
+    // Acos of dark values exceeds 255 and wraps around, the same way the direct conversion does on x86
+    std::array<uint8_t, 256> lut = {};
+    for (size_t value = 0; value < 256; ++value) {
+        lut[value] = static_cast<int>(acos(static_cast<int>(value) / 255.0) * 255);
+    }
+    bool direct = choice.variant == "direct";
+    auto& rows = image.pixel_array.rows;
+    Parallel::ForEachBand(rows.size(), choice.schedule, [&](size_t worker, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (auto &colour: rows[i].colours) {
+                if (direct) {
+                    colour.blue = acos(colour.blue / 255.0) * 255;
+                    colour.green = acos(colour.green / 255.0) * 255;
+                    colour.red = acos(colour.green / 255.0) * 255;
+                } else {
+                    colour.blue = lut[colour.blue];
+                    colour.green = lut[colour.green];
+                    colour.red = lut[colour.green];
+                }
+            }
         }
+    });
+}
+
+AutoLevels::AutoLevels(const std::vector<int>& params) : Filter(params) {
+    this->params = params;
+}
+
+void AutoLevels::ApplyFilter(BMP& image) {
+    Histogram histogram;
+    histogram.Compute(image.pixel_array);
+    image.ApplyLut(histogram.AutoLevelsLut());
+}
+
+bool AutoLevels::IsGlobal() const {
+    return true;
+}
+
+Equalize::Equalize(const std::vector<int>& params) : Filter(params) {
+    this->params = params;
+}
+
+void Equalize::ApplyFilter(BMP& image) {
+    Histogram histogram;
+    histogram.Compute(image.pixel_array);
+    image.ApplyLut(histogram.EqualizeLut());
+}
+
+bool Equalize::IsGlobal() const {
+    return true;
+}
+
+Gamma::Gamma(double gamma) {
+    if (gamma <= 0) {
+        throw std::invalid_argument("Gamma should be greater than 0");
+    }
+    this->gamma = gamma;
+}
+
+void Gamma::ApplyFilter(BMP& image) {
+    ChannelLut lut = {};
+    for (size_t value = 0; value < 256; ++value) {
+        double corrected = std::round(255.0 * std::pow(static_cast<double>(value) / 255.0, 1.0 / gamma));
+        lut[0][value] = lut[1][value] = lut[2][value] = static_cast<uint8_t>(std::min(255.0, corrected));
+    }
+    image.ApplyLut(lut);
+}
+
+Hist::Hist(const std::string& output_file_name) {
+    this->output_file_name = output_file_name;
+}
+
+void Hist::ApplyFilter(BMP& image) {
+    Histogram histogram;
+    histogram.Compute(image.pixel_array);
+    histogram.Write(output_file_name);
+}
+
+// Pixels pass through unchanged, the histogram of the whole output is rewritten if anything changed
+void Hist::ApplyIncremental(const BMP& input, BMP& output, const TileMap& output_tiles) {
+    if (!output_tiles.Any()) {
+        return;
     }
+    output = input;
+    ApplyFilter(output);
 }
@@ -14,6 +14,11 @@ public:
     Filter(const std::vector<int>& params);
     Filter() = default;
     virtual void ApplyFilter(BMP& image) = 0;
+    virtual size_t Footprint() const;
+    virtual bool WrapsRows() const;
+    virtual bool IsGlobal() const;
+    virtual TileMap DirtyTiles(const TileMap& input_tiles) const;
+    virtual void ApplyIncremental(const BMP& input, BMP& output, const TileMap& output_tiles);
     virtual ~Filter() = default;
 };
 
@@ -21,6 +26,8 @@ class Crop : public Filter {
 public:
     Crop(const std::vector<int>& params);
     void ApplyFilter(BMP& image);
+    TileMap DirtyTiles(const TileMap& input_tiles) const;
+    void ApplyIncremental(const BMP& input, BMP& output, const TileMap& output_tiles);
 };
 
 class Gs : public Filter {
@@ -28,6 +35,7 @@ public:
     Gs() = default;
     Gs(const std::vector<int>& params);
     void ApplyFilter(BMP& image);
+    void ApplyFilter(BMP& image, const KernelChoice& choice);
 };
 
 class Neg : public Filter {
@@ -35,6 +43,7 @@ public:
     Neg() = default;
     Neg(const std::vector<int>& params);
     void ApplyFilter(BMP& image);
+    void ApplyFilter(BMP& image, const KernelChoice& choice);
 };
 
 class Sharp : public Filter {
@@ -42,18 +51,27 @@ public:
     Sharp() = default;
     Sharp(const std::vector<int>& params);
     void ApplyFilter(BMP& image);
+    void ApplyFilter(BMP& image, const KernelChoice& choice);
+    size_t Footprint() const;
+    bool WrapsRows() const;
 };
 
 class Edge : public Filter {
 public:
     Edge(const std::vector<int>& params);
     void ApplyFilter(BMP& image);
+    size_t Footprint() const;
+    bool WrapsRows() const;
 };
 
 class Blur : public Filter {
 public:
     Blur(const std::vector<int>& params);
     void ApplyFilter(BMP& image);
+    void ApplyFilter(BMP& image, const KernelChoice& choice);
+    void ApplyDirect(BMP& image, const Schedule& schedule);
+    void ApplyTable(BMP& image, const Schedule& schedule);
+    size_t Footprint() const;
 };
 
 class Acos : public Filter {
@@ -61,6 +79,40 @@ public:
     Acos() = default;
     Acos(const std::vector<int>& params);
     void ApplyFilter(BMP& image);
+    void ApplyFilter(BMP& image, const KernelChoice& choice);
+};
+
+class AutoLevels : public Filter {
+public:
+    AutoLevels() = default;
+    AutoLevels(const std::vector<int>& params);
+    void ApplyFilter(BMP& image);
+    bool IsGlobal() const;
+};
+
+class Equalize : public Filter {
+public:
+    Equalize() = default;
+    Equalize(const std::vector<int>& params);
+    void ApplyFilter(BMP& image);
+    bool IsGlobal() const;
+};
+
+class Gamma : public Filter {
+public:
+    double gamma = 1.0;
+
+    Gamma(double gamma);
+    void ApplyFilter(BMP& image);
+};
+
+class Hist : public Filter {
+public:
+    std::string output_file_name;
+
+    Hist(const std::string& output_file_name);
+    void ApplyFilter(BMP& image);
+    void ApplyIncremental(const BMP& input, BMP& output, const TileMap& output_tiles);
 };
 
 #endif //OIMP_PROJECT_FILTER_H
\ No newline at end of file
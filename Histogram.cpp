@@ -0,0 +1,137 @@
+#include "Histogram.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Luma weights of Gs filter, summed in the same order so that luma histogram matches Gs output
+std::array<std::array<double, 256>, 3> MakeLumaWeights() {
+    std::array<std::array<double, 256>, 3> weights = {};
+    for (size_t value = 0; value < 256; ++value) {
+        weights[0][value] = 0.114 * static_cast<int>(value);
+        weights[1][value] = 0.587 * static_cast<int>(value);
+        weights[2][value] = 0.299 * static_cast<int>(value);
+    }
+    return weights;
+}
+
+const std::array<std::array<double, 256>, 3> LUMA_WEIGHTS = MakeLumaWeights();
+
+ChannelLut MakeIdentityLut() {
+    ChannelLut lut = {};
+    for (auto& channel_lut : lut) {
+        for (size_t value = 0; value < 256; ++value) {
+            channel_lut[value] = static_cast<uint8_t>(value);
+        }
+    }
+    return lut;
+}
+
+}  // namespace
+
+uint8_t Histogram::Luma(const Colour& colour) {
+    return static_cast<uint8_t>(static_cast<int>(LUMA_WEIGHTS[2][colour.red] + LUMA_WEIGHTS[1][colour.green] +
+                                                 LUMA_WEIGHTS[0][colour.blue]));
+}
+
+void Histogram::Compute(const PixelArray& pixel_array) {
+    size_t pixels_number = pixel_array.rows_number * pixel_array.rows_size;
+    Compute(pixel_array, Profile::Active().Choose("point", pixels_number).schedule);
+}
+
+void Histogram::Compute(const PixelArray& pixel_array, const Schedule& schedule) {
+    std::vector<Histogram> worker_histograms(Parallel::WorkersNumber(pixel_array.rows_number, schedule));
+    Parallel::ForEachBand(pixel_array.rows_number, schedule, [&](size_t worker, size_t begin, size_t end) {
+        Histogram& histogram = worker_histograms[worker];
+        for (size_t i = begin; i < end; ++i) {
+            for (const auto& colour : pixel_array.rows[i].colours) {
+                ++histogram.channels[0][colour.blue];
+                ++histogram.channels[1][colour.green];
+                ++histogram.channels[2][colour.red];
+                ++histogram.luma[Luma(colour)];
+            }
+            histogram.pixels_number += pixel_array.rows[i].colours.size();
+        }
+    });
+    *this = Histogram();
+    for (const auto& histogram : worker_histograms) {
+        Add(histogram);
+    }
+}
+
+void Histogram::Add(const Histogram& other) {
+    for (size_t value = 0; value < 256; ++value) {
+        for (size_t k = 0; k < 3; ++k) {
+            channels[k][value] += other.channels[k][value];
+        }
+        luma[value] += other.luma[value];
+    }
+    pixels_number += other.pixels_number;
+}
+
+void Histogram::Write(const std::string& output_file_name) {
+    std::ofstream output_file(output_file_name);
+    if (output_file.is_open()) {
+        output_file << "value,blue,green,red,luma\n";
+        for (size_t value = 0; value < 256; ++value) {
+            output_file << value << ',' << channels[0][value] << ',' << channels[1][value] << ','
+                        << channels[2][value] << ',' << luma[value] << '\n';
+        }
+        output_file.close();
+    } else {
+        throw std::invalid_argument("Not valid path to histogram file: " + output_file_name);
+    }
+}
+
+// Stretches every channel linearly so that its darkest used value becomes 0 and the brightest one becomes 255
+ChannelLut Histogram::AutoLevelsLut() const {
+    ChannelLut lut = MakeIdentityLut();
+    for (size_t k = 0; k < 3; ++k) {
+        size_t low = 0;
+        while (low < 256 && channels[k][low] == 0) {
+            ++low;
+        }
+        size_t high = 255;
+        while (high > low && channels[k][high] == 0) {
+            --high;
+        }
+        if (low >= high) {
+            continue;
+        }
+        for (size_t value = 0; value < 256; ++value) {
+            double stretched = std::round((static_cast<double>(value) - low) * 255.0 / (high - low));
+            lut[k][value] = static_cast<uint8_t>(std::max(0.0, std::min(255.0, stretched)));
+        }
+    }
+    return lut;
+}
+
+// Maps every channel through its normalized cumulative distribution
+ChannelLut Histogram::EqualizeLut() const {
+    ChannelLut lut = MakeIdentityLut();
+    for (size_t k = 0; k < 3; ++k) {
+        std::array<size_t, 256> cdf = {};
+        size_t sum = 0;
+        for (size_t value = 0; value < 256; ++value) {
+            sum += channels[k][value];
+            cdf[value] = sum;
+        }
+        size_t cdf_min = 0;
+        for (size_t value = 0; value < 256 && cdf_min == 0; ++value) {
+            cdf_min = cdf[value];
+        }
+        if (sum == cdf_min) {
+            continue;
+        }
+        for (size_t value = 0; value < 256; ++value) {
+            if (cdf[value] < cdf_min) {
+                lut[k][value] = 0;
+                continue;
+            }
+            double equalized = std::round(static_cast<double>(cdf[value] - cdf_min) * 255.0 / (sum - cdf_min));
+            lut[k][value] = static_cast<uint8_t>(equalized);
+        }
+    }
+    return lut;
+}
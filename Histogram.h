@@ -0,0 +1,26 @@
+#ifndef OIMP_PROJECT_HISTOGRAM_H
+#define OIMP_PROJECT_HISTOGRAM_H
+
+#pragma once
+
+#include <array>
+#include <string>
+#include "BMP.h"
+
+class Histogram {
+public:
+    std::array<std::array<size_t, 256>, 3> channels = {};
+    std::array<size_t, 256> luma = {};
+    size_t pixels_number = 0;
+
+    static uint8_t Luma(const Colour& colour);
+
+    void Compute(const PixelArray& pixel_array);
+    void Compute(const PixelArray& pixel_array, const Schedule& schedule);
+    void Add(const Histogram& other);
+    void Write(const std::string& output_file_name);
+    ChannelLut AutoLevelsLut() const;
+    ChannelLut EqualizeLut() const;
+};
+
+#endif //OIMP_PROJECT_HISTOGRAM_H
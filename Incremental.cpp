@@ -0,0 +1,116 @@
+#include "Incremental.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+Incremental::Incremental(const std::string& cache_dir, const std::string& chain) {
+    this->cache_dir = cache_dir;
+    this->chain = chain;
+}
+
+std::string Incremental::StageFileName(size_t stage) const {
+    return (std::filesystem::path(cache_dir) / ("stage" + std::to_string(stage) + ".bmp")).string();
+}
+
+std::string Incremental::TilesFileName() const {
+    return (std::filesystem::path(cache_dir) / "input.tiles").string();
+}
+
+std::string Incremental::ChainFileName() const {
+    return (std::filesystem::path(cache_dir) / "chain").string();
+}
+
+// The cache is usable if it was made by the same chain for an input of the same size
+bool Incremental::ReadState(const TileMap& tiles, size_t stages_number, std::vector<uint64_t>& hashes) const {
+    std::ifstream chain_file(ChainFileName());
+    std::string cached_chain((std::istreambuf_iterator<char>(chain_file)), std::istreambuf_iterator<char>());
+    if (!chain_file.is_open() || cached_chain != chain) {
+        return false;
+    }
+    std::ifstream tiles_file(TilesFileName());
+    size_t rows_number = 0;
+    size_t rows_size = 0;
+    size_t tile_side = 0;
+    if (!(tiles_file >> rows_number >> rows_size >> tile_side) || rows_number != tiles.rows_number ||
+        rows_size != tiles.rows_size || tile_side != TileMap::TILE_SIDE) {
+        return false;
+    }
+    hashes.assign(tiles.tile_rows * tiles.tile_cols, 0);
+    for (auto& hash : hashes) {
+        if (!(tiles_file >> hash)) {
+            return false;
+        }
+    }
+    for (size_t stage = 1; stage <= stages_number; ++stage) {
+        if (!std::filesystem::exists(StageFileName(stage))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Incremental::WriteState(const TileMap& tiles, const std::vector<uint64_t>& hashes) const {
+    std::ofstream tiles_file(TilesFileName());
+    std::ofstream chain_file(ChainFileName());
+    if (!tiles_file.is_open() || !chain_file.is_open()) {
+        throw std::invalid_argument("Not valid cache directory: " + cache_dir);
+    }
+    tiles_file << tiles.rows_number << ' ' << tiles.rows_size << ' ' << TileMap::TILE_SIDE << '\n';
+    for (uint64_t hash : hashes) {
+        tiles_file << hash << '\n';
+    }
+    chain_file << chain;
+}
+
+void Incremental::RunFull(BMP& image, std::vector<std::unique_ptr<Filter>>& filters) const {
+    for (size_t stage = 1; stage <= filters.size(); ++stage) {
+        filters[stage - 1]->ApplyFilter(image);
+        image.Write(StageFileName(stage));
+    }
+}
+
+// Keeps the output of every stage in cache_dir. On the next run tiles of the input whose hashes changed are
+// grown by the footprint of every filter, and only those tiles are recomputed and rewritten in every stage
+void Incremental::Run(BMP& image, std::vector<std::unique_ptr<Filter>>& filters) const {
+    std::error_code error;
+    std::filesystem::create_directories(cache_dir, error);
+    if (error) {
+        throw std::invalid_argument("Not valid cache directory: " + cache_dir);
+    }
+    TileMap tiles(image.pixel_array.rows_number, image.pixel_array.rows_size);
+    std::vector<uint64_t> hashes = image.TileHashes(tiles);
+    std::vector<uint64_t> cached_hashes;
+    bool valid = ReadState(tiles, filters.size(), cached_hashes);
+    // A run interrupted halfway leaves stages that match neither input, so the cache is invalid until it ends
+    std::filesystem::remove(TilesFileName(), error);
+    if (!valid) {
+        RunFull(image, filters);
+        WriteState(tiles, hashes);
+        return;
+    }
+    TileMap input_tiles = tiles;
+    for (size_t k = 0; k < hashes.size(); ++k) {
+        if (hashes[k] != cached_hashes[k]) {
+            input_tiles.dirty[k] = true;
+        }
+    }
+    for (size_t stage = 1; stage <= filters.size(); ++stage) {
+        Filter& filter = *filters[stage - 1];
+        TileMap output_tiles = filter.DirtyTiles(input_tiles);
+        BMP output;
+        output.Read(StageFileName(stage));
+        if (output.pixel_array.rows_number != output_tiles.rows_number ||
+            output.pixel_array.rows_size != output_tiles.rows_size) {
+            output = image;
+            filter.ApplyFilter(output);
+            output.Write(StageFileName(stage));
+            output_tiles.MarkAll();
+        } else if (output_tiles.Any()) {
+            filter.ApplyIncremental(image, output, output_tiles);
+            output.WriteTiles(StageFileName(stage), output_tiles);
+        }
+        image = std::move(output);
+        input_tiles = std::move(output_tiles);
+    }
+    WriteState(tiles, hashes);
+}
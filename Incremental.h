@@ -0,0 +1,28 @@
+#ifndef OIMP_PROJECT_INCREMENTAL_H
+#define OIMP_PROJECT_INCREMENTAL_H
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "BMP.h"
+#include "Filter.h"
+
+class Incremental {
+public:
+    std::string cache_dir;
+    std::string chain;
+
+    Incremental(const std::string& cache_dir, const std::string& chain);
+
+    std::string StageFileName(size_t stage) const;
+    std::string TilesFileName() const;
+    std::string ChainFileName() const;
+    bool ReadState(const TileMap& tiles, size_t stages_number, std::vector<uint64_t>& hashes) const;
+    void WriteState(const TileMap& tiles, const std::vector<uint64_t>& hashes) const;
+    void RunFull(BMP& image, std::vector<std::unique_ptr<Filter>>& filters) const;
+    void Run(BMP& image, std::vector<std::unique_ptr<Filter>>& filters) const;
+};
+
+#endif //OIMP_PROJECT_INCREMENTAL_H
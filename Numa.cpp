@@ -0,0 +1,123 @@
+#include "Numa.h"
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+bool Numa::enabled = false;
+
+namespace {
+
+// Parses sysfs cpu lists like "0-3,8-11"
+std::vector<int> ParseCpuList(const std::string& cpu_list) {
+    std::vector<int> cpus;
+    std::istringstream list_stream(cpu_list);
+    std::string range;
+    while (std::getline(list_stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+class Topology {
+public:
+    std::vector<int> cpus;
+    std::map<int, int> cpu_nodes;
+
+    Topology() {
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        sched_getaffinity(0, sizeof(allowed), &allowed);
+        for (int node = 0;; ++node) {
+            std::ifstream cpu_list_file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!cpu_list_file.is_open()) {
+                break;
+            }
+            std::string cpu_list;
+            std::getline(cpu_list_file, cpu_list);
+            for (int cpu : ParseCpuList(cpu_list)) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back(cpu);
+                    cpu_nodes[cpu] = node;
+                }
+            }
+        }
+        if (cpus.empty()) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back(cpu);
+                    cpu_nodes[cpu] = 0;
+                }
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            cpus.push_back(0);
+            cpu_nodes[0] = 0;
+        }
+    }
+};
+
+const Topology& GetTopology() {
+    static Topology topology;
+    return topology;
+}
+
+}  // namespace
+
+// Allowed cpus ordered node by node, so that neighbouring workers share a node
+const std::vector<int>& Numa::Cpus() {
+    return GetTopology().cpus;
+}
+
+int Numa::NodeOfCpu(int cpu) {
+    auto it = GetTopology().cpu_nodes.find(cpu);
+    return it == GetTopology().cpu_nodes.end() ? -1 : it->second;
+}
+
+int Numa::CurrentNode() {
+#ifdef __linux__
+    return NodeOfCpu(sched_getcpu());
+#else
+    return -1;
+#endif
+}
+
+// Returns the node holding the page of address, or -1 if it is unknown
+int Numa::NodeOfAddress(const void* address) {
+#if defined(__linux__) && defined(SYS_move_pages)
+    void* page = const_cast<void*>(address);
+    int status = -1;
+    if (syscall(SYS_move_pages, 0, 1, &page, nullptr, &status, 0) != 0) {
+        return -1;
+    }
+    return status;
+#else
+    return -1;
+#endif
+}
+
+void Numa::PinCurrentThread(size_t worker) {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(Cpus()[worker % Cpus().size()], &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+}
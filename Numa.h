@@ -0,0 +1,20 @@
+#ifndef OIMP_PROJECT_NUMA_H
+#define OIMP_PROJECT_NUMA_H
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class Numa {
+public:
+    static bool enabled;
+
+    static const std::vector<int>& Cpus();
+    static int NodeOfCpu(int cpu);
+    static int CurrentNode();
+    static int NodeOfAddress(const void* address);
+    static void PinCurrentThread(size_t worker);
+};
+
+#endif //OIMP_PROJECT_NUMA_H
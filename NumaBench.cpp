@@ -0,0 +1,58 @@
+#include "NumaBench.h"
+#include "Filter.h"
+#include "Numa.h"
+#include "Tuner.h"
+#include <chrono>
+#include <memory>
+#include <set>
+
+NumaBench::NumaBench(std::ostream& log) : log(log) {
+}
+
+// Share of rows whose pages are on the node of the worker that processes them
+double NumaBench::LocalRowsShare(const PixelArray& pixel_array) {
+    Schedule schedule;
+    std::vector<size_t> local_rows(Parallel::WorkersNumber(pixel_array.rows_number, schedule), 0);
+    Parallel::ForEachBand(pixel_array.rows_number, schedule, [&](size_t worker, size_t begin, size_t end) {
+        int node = Numa::CurrentNode();
+        for (size_t i = begin; i < end; ++i) {
+            if (node >= 0 && Numa::NodeOfAddress(pixel_array.rows[i].colours.data()) == node) {
+                ++local_rows[worker];
+            }
+        }
+    });
+    size_t local_rows_number = 0;
+    for (size_t rows_number : local_rows) {
+        local_rows_number += rows_number;
+    }
+    return pixel_array.rows_number == 0 ? 0 : 100.0 * local_rows_number / pixel_array.rows_number;
+}
+
+// Runs the same chain with buffers first touched by the calling thread and by pinned workers, and reports
+// locality after every stage, since buffers of later stages reuse memory freed by earlier ones
+void NumaBench::Run() {
+    std::set<int> nodes;
+    for (int cpu : Numa::Cpus()) {
+        nodes.insert(Numa::NodeOfCpu(cpu));
+    }
+    log << "cpus: " << Numa::Cpus().size() << ", nodes: " << nodes.size() << std::endl;
+    for (bool numa : {false, true}) {
+        Numa::enabled = numa;
+        BMP image = Tuner::MakeSyntheticImage(SIDE, SIDE);
+        log << "numa " << (numa ? "on" : "off") << ": rows local to their worker: input "
+            << LocalRowsShare(image.pixel_array) << "%";
+        std::chrono::duration<double, std::milli> elapsed(0);
+        std::vector<std::pair<std::string, std::unique_ptr<Filter>>> stages;
+        stages.emplace_back("sharp", std::make_unique<Sharp>());
+        stages.emplace_back("blur", std::make_unique<Blur>(std::vector{BLUR_SIGMA}));
+        stages.emplace_back("gs", std::make_unique<Gs>());
+        for (auto& [name, filter] : stages) {
+            auto start = std::chrono::steady_clock::now();
+            filter->ApplyFilter(image);
+            elapsed += std::chrono::steady_clock::now() - start;
+            log << ", after " << name << " " << LocalRowsShare(image.pixel_array) << "%";
+        }
+        log << ", filters took " << elapsed.count() << " ms" << std::endl;
+    }
+    Numa::enabled = false;
+}
@@ -0,0 +1,22 @@
+#ifndef OIMP_PROJECT_NUMABENCH_H
+#define OIMP_PROJECT_NUMABENCH_H
+
+#pragma once
+
+#include <ostream>
+#include "BMP.h"
+
+class NumaBench {
+public:
+    static const int SIDE = 2048;
+    static const int BLUR_SIGMA = 1;
+
+    std::ostream& log;
+
+    explicit NumaBench(std::ostream& log);
+
+    static double LocalRowsShare(const PixelArray& pixel_array);
+    void Run();
+};
+
+#endif //OIMP_PROJECT_NUMABENCH_H
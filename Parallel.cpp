@@ -0,0 +1,142 @@
+#include "Parallel.h"
+#include "Numa.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Threads pinned to Numa::Cpus() once and kept for the whole run. Every stage of a chain gives band k to the same
+// thread, and so to the same malloc arena, so rows freed by one stage are reused on the same node by the next one
+class PinnedPool {
+public:
+    explicit PinnedPool(size_t threads_number) {
+        for (size_t worker = 0; worker < threads_number; ++worker) {
+            threads_.emplace_back([this, worker] { Loop(worker); });
+        }
+    }
+
+    ~PinnedPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    // Calls work(worker) for every worker below workers_number and waits for all of them
+    void Run(size_t workers_number, const std::function<void(size_t)>& work) {
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_ = &work;
+        workers_number_ = workers_number;
+        pending_ = threads_.size();
+        ++generation_;
+        start_.notify_all();
+        done_.wait(lock, [this] { return pending_ == 0; });
+        work_ = nullptr;
+    }
+
+private:
+    std::vector<std::thread> threads_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const std::function<void(size_t)>* work_ = nullptr;
+    size_t workers_number_ = 0;
+    size_t pending_ = 0;
+    size_t generation_ = 0;
+    bool stop_ = false;
+
+    void Loop(size_t worker) {
+        Numa::PinCurrentThread(worker);
+        size_t seen_generation = 0;
+        while (true) {
+            const std::function<void(size_t)>* work = nullptr;
+            size_t workers_number = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+                if (stop_) {
+                    return;
+                }
+                seen_generation = generation_;
+                work = work_;
+                workers_number = workers_number_;
+            }
+            if (worker < workers_number) {
+                (*work)(worker);
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+};
+
+PinnedPool& GetPinnedPool() {
+    static PinnedPool pool(Numa::Cpus().size());
+    return pool;
+}
+
+}  // namespace
+
+size_t Schedule::DefaultThreadsNumber() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// In NUMA mode every stage uses one contiguous band per allowed cpu regardless of the profile, so that a row
+// is processed by the same pinned worker, and allocated on its node, through the whole chain
+Schedule Parallel::Effective(size_t rows_number, const Schedule& schedule) {
+    if (!Numa::enabled) {
+        return schedule;
+    }
+    Schedule numa_schedule;
+    numa_schedule.threads_number = Numa::Cpus().size();
+    numa_schedule.band_rows = std::max(static_cast<size_t>(1),
+                                       (rows_number + numa_schedule.threads_number - 1) / numa_schedule.threads_number);
+    return numa_schedule;
+}
+
+size_t Parallel::WorkersNumber(size_t rows_number, const Schedule& requested_schedule) {
+    Schedule schedule = Effective(rows_number, requested_schedule);
+    size_t band_rows = std::max(static_cast<size_t>(1), schedule.band_rows);
+    size_t bands_number = (rows_number + band_rows - 1) / band_rows;
+    return std::max(static_cast<size_t>(1), std::min(schedule.threads_number, bands_number));
+}
+
+// Splits rows [0, rows_number) into bands of schedule.band_rows rows and calls body(worker, begin, end) for each
+// of them. Band k always goes to worker k % workers, so the same rows are processed by the same worker in every
+// call with the same schedule. Worker 0 runs in the calling thread, except in NUMA mode, where all bands go to
+// the pinned pool and the calling thread only waits
+void Parallel::ForEachBand(size_t rows_number, const Schedule& requested_schedule,
+                           const std::function<void(size_t, size_t, size_t)>& body) {
+    Schedule schedule = Effective(rows_number, requested_schedule);
+    size_t band_rows = std::max(static_cast<size_t>(1), schedule.band_rows);
+    size_t workers_number = WorkersNumber(rows_number, schedule);
+    auto work = [&](size_t worker) {
+        for (size_t begin = worker * band_rows; begin < rows_number; begin += workers_number * band_rows) {
+            body(worker, begin, std::min(rows_number, begin + band_rows));
+        }
+    };
+    if (Numa::enabled) {
+        GetPinnedPool().Run(workers_number, work);
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(workers_number - 1);
+    for (size_t worker = 1; worker < workers_number; ++worker) {
+        workers.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
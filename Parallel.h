@@ -0,0 +1,25 @@
+#ifndef OIMP_PROJECT_PARALLEL_H
+#define OIMP_PROJECT_PARALLEL_H
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+class Schedule {
+public:
+    size_t threads_number = DefaultThreadsNumber();
+    size_t band_rows = 32;
+
+    static size_t DefaultThreadsNumber();
+};
+
+class Parallel {
+public:
+    static Schedule Effective(size_t rows_number, const Schedule& schedule);
+    static size_t WorkersNumber(size_t rows_number, const Schedule& schedule);
+    static void ForEachBand(size_t rows_number, const Schedule& schedule,
+                            const std::function<void(size_t, size_t, size_t)>& body);
+};
+
+#endif //OIMP_PROJECT_PARALLEL_H
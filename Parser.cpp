@@ -2,8 +2,10 @@
 #include "Filter.h"
 #include <iostream>
 #include <memory>
+#include <algorithm>
 
-const std::vector<std::string> FILTERS = {"-crop", "-gs", "-neg", "-sharp", "-edge", "-blur", "-acos"};
+const std::vector<std::string> FILTERS = {"-crop", "-gs", "-neg", "-sharp", "-edge", "-blur", "-acos",
+                                          "-autolevels", "-equalize", "-gamma", "-hist"};
 
 bool Parser::IsNumber(const char *arg) {
     for (const char *ch = arg; *ch != '\0'; ++ch) {
@@ -14,6 +16,21 @@ bool Parser::IsNumber(const char *arg) {
     return true;
 }
 
+bool Parser::IsFractional(const char *arg) {
+    size_t points = 0;
+    size_t digits = 0;
+    for (const char *ch = arg; *ch != '\0'; ++ch) {
+        if (*ch == '.') {
+            ++points;
+        } else if ('0' <= *ch && *ch <= '9') {
+            ++digits;
+        } else {
+            return false;
+        }
+    }
+    return points <= 1 && digits > 0;
+}
+
 void Parser::ParseCrop(size_t ind) {
     if (ind >= argc - 2) {
         throw std::invalid_argument("Not enough arguments for Crop filter");
@@ -62,6 +79,34 @@ void Parser::ParseAcos() {
     using_filters.push_back(std::make_unique<Acos>());
 }
 
+void Parser::ParseAutoLevels() {
+    using_filters.push_back(std::make_unique<AutoLevels>());
+}
+
+void Parser::ParseEqualize() {
+    using_filters.push_back(std::make_unique<Equalize>());
+}
+
+void Parser::ParseGamma(size_t ind) {
+    if (ind + 1 >= static_cast<size_t>(argc)) {
+        throw std::invalid_argument("Not enough arguments for Gamma filter");
+    }
+    if (!IsFractional(argv[ind + 1])) {
+        throw std::invalid_argument("Argument for Gamma filter should be a positive number");
+    }
+    using_filters.push_back(std::make_unique<Gamma>(std::stod(argv[ind + 1])));
+}
+
+void Parser::ParseHist(size_t ind) {
+    if (ind + 1 >= static_cast<size_t>(argc)) {
+        throw std::invalid_argument("Not enough arguments for Hist filter");
+    }
+    if (argv[ind + 1][0] == '-') {
+        throw std::invalid_argument("Argument for Hist filter should be a path to file, not an option");
+    }
+    using_filters.push_back(std::make_unique<Hist>(argv[ind + 1]));
+}
+
 size_t Parser::ParseFilter(size_t ind) {
     std::string filter_name = argv[ind];
     if (std::find(FILTERS.begin(), FILTERS.end(), filter_name) == FILTERS.end()) {
@@ -91,25 +136,81 @@ size_t Parser::ParseFilter(size_t ind) {
         ParseAcos();
         return 1;
     }
+    if (filter_name == "-autolevels") {
+        ParseAutoLevels();
+        return 1;
+    }
+    if (filter_name == "-equalize") {
+        ParseEqualize();
+        return 1;
+    }
+    if (filter_name == "-gamma") {
+        ParseGamma(ind);
+        return 2;
+    }
+    if (filter_name == "-hist") {
+        ParseHist(ind);
+        return 2;
+    }
     ParseBlur(ind);
     return 2;
 }
 
+size_t Parser::ParseOption(size_t ind) {
+    std::string option = argv[ind];
+    if (option == "--numa") {
+        numa = true;
+        return 1;
+    }
+    if (option == "--incremental") {
+        if (ind + 1 >= static_cast<size_t>(argc)) {
+            throw std::invalid_argument("Not enough arguments for --incremental");
+        }
+        cache_dir = argv[ind + 1];
+        return 2;
+    }
+    throw std::invalid_argument("No such option " + option);
+}
+
 void Parser::ParseArgs() {
-    if (argc >= 2) {
-        input_file = argv[1];
+    if (argc >= 2 && std::string(argv[1]) == "--tune") {
+        if (argc > 3) {
+            throw std::invalid_argument("Too many arguments for --tune");
+        }
+        tune = true;
+        profile_file = argc == 3 ? argv[2] : Profile::DefaultFileName();
+        return;
+    }
+    profile_file = Profile::DefaultFileName();
+    if (argc >= 2 && std::string(argv[1]) == "--numa-bench") {
+        if (argc > 2) {
+            throw std::invalid_argument("Too many arguments for --numa-bench");
+        }
+        numa_bench = true;
+        return;
+    }
+    size_t args_number = static_cast<size_t>(argc);
+    size_t first = 1;
+    while (first < args_number && std::string(argv[first]).starts_with("--")) {
+        first += ParseOption(first);
+    }
+    if (args_number >= first + 1) {
+        input_file = argv[first];
     } else {
         throw std::invalid_argument("No path to input file");
     }
-    if (argc >= 3) {
-        output_file = argv[2];
+    if (args_number >= first + 2) {
+        output_file = argv[first + 1];
     } else {
         throw std::invalid_argument("No path to output file");
     }
-    if (argc >= 4) {
-        size_t ind = 3;
+    for (size_t ind = first + 2; ind < args_number; ++ind) {
+        chain += std::string(argv[ind]) + "\n";
+    }
+    if (args_number >= first + 3) {
+        size_t ind = first + 2;
         size_t delta;
-        while (ind < argc) {
+        while (ind < args_number) {
             delta = ParseFilter(ind);
             ind += delta;
         }
@@ -1,6 +1,7 @@
 #ifndef CPP_PILOT_HSE_PARSER_H
 #define CPP_PILOT_HSE_PARSER_H
 
+#include <memory>
 #include <vector>
 #include "Filter.h"
 
@@ -9,12 +10,19 @@ public:
     std::vector<std::unique_ptr<Filter>> using_filters;
     std::string input_file;
     std::string output_file;
+    bool tune = false;
+    bool numa_bench = false;
+    bool numa = false;
+    std::string cache_dir;
+    std::string chain;
+    std::string profile_file;
     int argc = 0;
     char** argv;
 
     Parser(int argc, char** argv);
 
     bool IsNumber(const char* arg);
+    bool IsFractional(const char* arg);
     void ParseCrop(size_t ind);
     void ParseGs();
     void ParseNeg();
@@ -22,7 +30,12 @@ public:
     void ParseEdge(size_t ind);
     void ParseBlur(size_t ind);
     void ParseAcos();
+    void ParseAutoLevels();
+    void ParseEqualize();
+    void ParseGamma(size_t ind);
+    void ParseHist(size_t ind);
     size_t ParseFilter(size_t ind);
+    size_t ParseOption(size_t ind);
     void ParseArgs();
 };
 
@@ -0,0 +1,99 @@
+#include "Profile.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// The first variant of every kernel is the default one used when there is no profile
+const std::map<std::string, std::vector<std::string>> Profile::VARIANTS = {
+    {"blur", {"table", "direct"}},
+    {"matrix", {"indexed", "direct"}},
+    {"point", {"lut", "direct"}},
+};
+
+Profile& Profile::Active() {
+    static Profile profile;
+    return profile;
+}
+
+std::string Profile::DefaultFileName() {
+    const char* file_name = std::getenv("IMAGE_PROCESSOR_PROFILE");
+    if (file_name != nullptr && *file_name != '\0') {
+        return file_name;
+    }
+    return "image_processor.profile";
+}
+
+std::string Profile::SizeClass(size_t pixels_number) {
+    return pixels_number >= LARGE_IMAGE_PIXELS ? "large" : "small";
+}
+
+KernelChoice Profile::DefaultChoice(const std::string& kernel) {
+    KernelChoice choice;
+    choice.variant = VARIANTS.at(kernel).front();
+    return choice;
+}
+
+KernelChoice Profile::Choose(const std::string& kernel, size_t pixels_number) const {
+    auto it = choices.find(kernel + "." + SizeClass(pixels_number));
+    if (it == choices.end()) {
+        return DefaultChoice(kernel);
+    }
+    return it->second;
+}
+
+// Every line of a profile is "<kernel>.<small|large> <variant> <threads number> <band rows>",
+// lines starting with '#' are comments
+void Profile::Read(const std::string& input_file_name) {
+    std::ifstream input_file(input_file_name);
+    if (!input_file.is_open()) {
+        throw std::invalid_argument("Not valid path to profile file: " + input_file_name);
+    }
+    std::map<std::string, KernelChoice> read_choices;
+    std::string line;
+    while (std::getline(input_file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream line_stream(line);
+        std::string key;
+        KernelChoice choice;
+        long long threads_number = 0;
+        long long band_rows = 0;
+        if (!(line_stream >> key >> choice.variant >> threads_number >> band_rows)) {
+            throw std::invalid_argument("Not valid line in profile file " + input_file_name + ": " + line);
+        }
+        std::string kernel = key.substr(0, key.find('.'));
+        std::string size_class = key.find('.') == std::string::npos ? "" : key.substr(key.find('.') + 1);
+        if (!VARIANTS.contains(kernel) || (size_class != "small" && size_class != "large")) {
+            throw std::invalid_argument("Unknown kernel in profile file " + input_file_name + ": " + key);
+        }
+        const auto& variants = VARIANTS.at(kernel);
+        if (std::find(variants.begin(), variants.end(), choice.variant) == variants.end()) {
+            throw std::invalid_argument("Unknown variant of " + kernel + " in profile file " + input_file_name +
+                                        ": " + choice.variant);
+        }
+        if (threads_number <= 0 || band_rows <= 0) {
+            throw std::invalid_argument("Threads number and band rows in profile file should be positive: " + line);
+        }
+        choice.schedule.threads_number = std::min(static_cast<size_t>(threads_number), Schedule::DefaultThreadsNumber());
+        choice.schedule.band_rows = static_cast<size_t>(band_rows);
+        read_choices[key] = choice;
+    }
+    choices = std::move(read_choices);
+}
+
+void Profile::Write(const std::string& output_file_name) {
+    std::ofstream output_file(output_file_name);
+    if (output_file.is_open()) {
+        output_file << "# <kernel>.<small|large> <variant> <threads number> <band rows>\n";
+        for (const auto& [key, choice] : choices) {
+            output_file << key << ' ' << choice.variant << ' ' << choice.schedule.threads_number << ' '
+                        << choice.schedule.band_rows << '\n';
+        }
+        output_file.close();
+    } else {
+        throw std::invalid_argument("Not valid path to profile file: " + output_file_name);
+    }
+}
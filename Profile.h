@@ -0,0 +1,34 @@
+#ifndef OIMP_PROJECT_PROFILE_H
+#define OIMP_PROJECT_PROFILE_H
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Parallel.h"
+
+class KernelChoice {
+public:
+    std::string variant;
+    Schedule schedule;
+};
+
+class Profile {
+public:
+    static const size_t LARGE_IMAGE_PIXELS = 512 * 512;
+    static const std::map<std::string, std::vector<std::string>> VARIANTS;
+
+    std::map<std::string, KernelChoice> choices;
+
+    static Profile& Active();
+    static std::string DefaultFileName();
+    static std::string SizeClass(size_t pixels_number);
+    static KernelChoice DefaultChoice(const std::string& kernel);
+
+    KernelChoice Choose(const std::string& kernel, size_t pixels_number) const;
+    void Read(const std::string& input_file_name);
+    void Write(const std::string& output_file_name);
+};
+
+#endif //OIMP_PROJECT_PROFILE_H
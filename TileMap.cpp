@@ -0,0 +1,94 @@
+#include "TileMap.h"
+#include <algorithm>
+
+TileMap::TileMap(size_t rows_number, size_t rows_size) {
+    this->rows_number = rows_number;
+    this->rows_size = rows_size;
+    tile_rows = (rows_number + TILE_SIDE - 1) / TILE_SIDE;
+    tile_cols = (rows_size + TILE_SIDE - 1) / TILE_SIDE;
+    dirty.assign(tile_rows * tile_cols, false);
+}
+
+bool TileMap::IsDirty(size_t tile_row, size_t tile_col) const {
+    return dirty[tile_row * tile_cols + tile_col];
+}
+
+void TileMap::Mark(size_t tile_row, size_t tile_col) {
+    dirty[tile_row * tile_cols + tile_col] = true;
+}
+
+void TileMap::MarkAll() {
+    dirty.assign(tile_rows * tile_cols, true);
+}
+
+bool TileMap::Any() const {
+    return std::find(dirty.begin(), dirty.end(), true) != dirty.end();
+}
+
+// Marks every tile that has a dirty pixel within radius pixels of it
+TileMap TileMap::Grow(size_t radius) const {
+    size_t tiles_radius = (radius + TILE_SIDE - 1) / TILE_SIDE;
+    TileMap grown(rows_number, rows_size);
+    for (size_t tile_row = 0; tile_row < tile_rows; ++tile_row) {
+        for (size_t tile_col = 0; tile_col < tile_cols; ++tile_col) {
+            if (!IsDirty(tile_row, tile_col)) {
+                continue;
+            }
+            size_t first_row = tile_row >= tiles_radius ? tile_row - tiles_radius : 0;
+            size_t last_row = std::min(tile_rows - 1, tile_row + tiles_radius);
+            size_t first_col = tile_col >= tiles_radius ? tile_col - tiles_radius : 0;
+            size_t last_col = std::min(tile_cols - 1, tile_col + tiles_radius);
+            for (size_t i = first_row; i <= last_row; ++i) {
+                for (size_t j = first_col; j <= last_col; ++j) {
+                    grown.Mark(i, j);
+                }
+            }
+        }
+    }
+    return grown;
+}
+
+// Keeps the tiles of the top left new_rows_number x new_rows_size pixels, as Crop does
+TileMap TileMap::Resize(size_t new_rows_number, size_t new_rows_size) const {
+    TileMap resized(new_rows_number, new_rows_size);
+    for (size_t tile_row = 0; tile_row < std::min(tile_rows, resized.tile_rows); ++tile_row) {
+        for (size_t tile_col = 0; tile_col < std::min(tile_cols, resized.tile_cols); ++tile_col) {
+            if (IsDirty(tile_row, tile_col)) {
+                resized.Mark(tile_row, tile_col);
+            }
+        }
+    }
+    return resized;
+}
+
+// Returns [first, last) ranges of consecutive dirty tiles in tile_row
+std::vector<std::pair<size_t, size_t>> TileMap::DirtyRuns(size_t tile_row) const {
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t tile_col = 0; tile_col < tile_cols; ++tile_col) {
+        if (!IsDirty(tile_row, tile_col)) {
+            continue;
+        }
+        if (!runs.empty() && runs.back().second == tile_col) {
+            ++runs.back().second;
+        } else {
+            runs.emplace_back(tile_col, tile_col + 1);
+        }
+    }
+    return runs;
+}
+
+size_t TileMap::RowBegin(size_t tile_row) const {
+    return tile_row * TILE_SIDE;
+}
+
+size_t TileMap::RowEnd(size_t tile_row) const {
+    return std::min(rows_number, (tile_row + 1) * TILE_SIDE);
+}
+
+size_t TileMap::ColBegin(size_t tile_col) const {
+    return tile_col * TILE_SIDE;
+}
+
+size_t TileMap::ColEnd(size_t tile_col) const {
+    return std::min(rows_size, (tile_col + 1) * TILE_SIDE);
+}
@@ -0,0 +1,36 @@
+#ifndef OIMP_PROJECT_TILEMAP_H
+#define OIMP_PROJECT_TILEMAP_H
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class TileMap {
+public:
+    static const size_t TILE_SIDE = 64;
+
+    size_t rows_number = 0;
+    size_t rows_size = 0;
+    size_t tile_rows = 0;
+    size_t tile_cols = 0;
+    std::vector<bool> dirty;
+
+    TileMap() = default;
+    TileMap(size_t rows_number, size_t rows_size);
+
+    bool IsDirty(size_t tile_row, size_t tile_col) const;
+    void Mark(size_t tile_row, size_t tile_col);
+    void MarkAll();
+    bool Any() const;
+    TileMap Grow(size_t radius) const;
+    TileMap Resize(size_t new_rows_number, size_t new_rows_size) const;
+    std::vector<std::pair<size_t, size_t>> DirtyRuns(size_t tile_row) const;
+    size_t RowBegin(size_t tile_row) const;
+    size_t RowEnd(size_t tile_row) const;
+    size_t ColBegin(size_t tile_col) const;
+    size_t ColEnd(size_t tile_col) const;
+};
+
+#endif //OIMP_PROJECT_TILEMAP_H
@@ -0,0 +1,110 @@
+#include "Tuner.h"
+#include "Filter.h"
+#include <chrono>
+#include <random>
+
+Tuner::Tuner(std::ostream& log) : log(log) {
+}
+
+BMP Tuner::MakeSyntheticImage(int width, int height) {
+    BMP image;
+    image.header.offset = 54;
+    image.dib.width = image.width = width;
+    image.dib.height = image.height = height;
+    image.RenewSize();
+    image.pixel_array.Make(height, width);
+    std::mt19937 generator(width * height);
+    std::uniform_int_distribution<int> noise(0, 255);
+    for (auto& row : image.pixel_array.rows) {
+        for (auto& colour : row.colours) {
+            colour = Colour({static_cast<uint8_t>(noise(generator)), static_cast<uint8_t>(noise(generator)),
+                             static_cast<uint8_t>(noise(generator))});
+        }
+    }
+    return image;
+}
+
+std::vector<Schedule> Tuner::CandidateSchedules() {
+    std::vector<size_t> threads_numbers;
+    for (size_t threads_number = 1; threads_number < Schedule::DefaultThreadsNumber(); threads_number *= 2) {
+        threads_numbers.push_back(threads_number);
+    }
+    threads_numbers.push_back(Schedule::DefaultThreadsNumber());
+    std::vector<Schedule> schedules;
+    for (size_t threads_number : threads_numbers) {
+        for (size_t band_rows : {8, 32, 128}) {
+            Schedule schedule;
+            schedule.threads_number = threads_number;
+            schedule.band_rows = band_rows;
+            schedules.push_back(schedule);
+        }
+    }
+    return schedules;
+}
+
+// Returns the best time in milliseconds among several runs of kernel on copies of image
+double Tuner::Measure(const BMP& image, const std::function<void(BMP&)>& kernel, size_t repeats) {
+    double best = 0;
+    for (size_t repeat = 0; repeat < repeats; ++repeat) {
+        BMP copy = image;
+        auto start = std::chrono::steady_clock::now();
+        kernel(copy);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (repeat == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+// Picks the fastest variant with the default schedule first, then the fastest schedule for that variant
+KernelChoice Tuner::TuneKernel(const std::string& kernel, const BMP& image,
+                               const std::function<void(BMP&, const KernelChoice&)>& run) {
+    std::string key = kernel + "." + Profile::SizeClass(image.PixelsNumber());
+    KernelChoice best = Profile::DefaultChoice(kernel);
+    double best_time = -1;
+    auto try_choice = [&](const KernelChoice& choice) {
+        double time = Measure(image, [&](BMP& copy) { run(copy, choice); }, REPEATS);
+        log << key << ' ' << choice.variant << " threads=" << choice.schedule.threads_number
+            << " band_rows=" << choice.schedule.band_rows << ": " << time << " ms" << std::endl;
+        if (best_time < 0 || time < best_time) {
+            best = choice;
+            best_time = time;
+        }
+    };
+    for (const auto& variant : Profile::VARIANTS.at(kernel)) {
+        KernelChoice choice;
+        choice.variant = variant;
+        try_choice(choice);
+    }
+    std::string variant = best.variant;
+    for (const auto& schedule : CandidateSchedules()) {
+        KernelChoice choice;
+        choice.variant = variant;
+        choice.schedule = schedule;
+        try_choice(choice);
+    }
+    log << key << " -> " << best.variant << " threads=" << best.schedule.threads_number
+        << " band_rows=" << best.schedule.band_rows << std::endl;
+    return best;
+}
+
+Profile Tuner::Run() {
+    Profile profile;
+    for (int side : {SMALL_SIDE, LARGE_SIDE}) {
+        BMP image = MakeSyntheticImage(side, side);
+        std::string size_class = Profile::SizeClass(image.PixelsNumber());
+        profile.choices["blur." + size_class] = TuneKernel("blur", image, [](BMP& copy, const KernelChoice& choice) {
+            Blur(std::vector{BLUR_SIGMA}).ApplyFilter(copy, choice);
+        });
+        profile.choices["matrix." + size_class] = TuneKernel("matrix", image, [](BMP& copy, const KernelChoice& choice) {
+            Sharp().ApplyFilter(copy, choice);
+        });
+        profile.choices["point." + size_class] = TuneKernel("point", image, [](BMP& copy, const KernelChoice& choice) {
+            Gs().ApplyFilter(copy, choice);
+            Neg().ApplyFilter(copy, choice);
+            Acos().ApplyFilter(copy, choice);
+        });
+    }
+    return profile;
+}
@@ -0,0 +1,30 @@
+#ifndef OIMP_PROJECT_TUNER_H
+#define OIMP_PROJECT_TUNER_H
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include "BMP.h"
+#include "Profile.h"
+
+class Tuner {
+public:
+    static const int SMALL_SIDE = 256;
+    static const int LARGE_SIDE = 768;
+    static const int BLUR_SIGMA = 1;
+    static const size_t REPEATS = 3;
+
+    std::ostream& log;
+
+    explicit Tuner(std::ostream& log);
+
+    static BMP MakeSyntheticImage(int width, int height);
+    static std::vector<Schedule> CandidateSchedules();
+    double Measure(const BMP& image, const std::function<void(BMP&)>& kernel, size_t repeats);
+    KernelChoice TuneKernel(const std::string& kernel, const BMP& image,
+                            const std::function<void(BMP&, const KernelChoice&)>& run);
+    Profile Run();
+};
+
+#endif //OIMP_PROJECT_TUNER_H
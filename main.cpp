@@ -2,7 +2,12 @@
 #include <vector>
 
 #include "BMP.h"
+#include "Incremental.h"
+#include "Numa.h"
+#include "NumaBench.h"
 #include "Parser.h"
+#include "Profile.h"
+#include "Tuner.h"
 
 inline void PrintException(std::invalid_argument& e) {
     std::cerr << "Error: " << e.what() << std::endl;
@@ -25,7 +30,30 @@ inline void PrintHelp() {
            "\t4) sharp: increase sharpness, no parameters need\n"
            "\t5) edge: highlight edges of objects in the photo, parameter is an integer number from 0 to 255\n"
            "\t6) blur: blur your photo, parameter is an integer number - the more this number the more blur applies\n"
-           "\t7) acos: somehow convert the colours of your photo";
+           "\t7) acos: somehow convert the colours of your photo\n"
+           "\t8) autolevels: stretch every colour channel to the full range, no parameters need\n"
+           "\t9) equalize: equalize histogram of every colour channel, no parameters need\n"
+           "\t10) gamma: gamma correction, parameter is a positive number - values greater than 1 brighten "
+           "the photo\n"
+           "\t11) hist: write histograms of colour channels and luma of the current photo to a CSV file, "
+           "parameter is path to this file\n"
+           "Tuning:\n"
+           "\t--tune <optional path to profile file>: benchmark kernels on this machine and save the fastest ones "
+           "to the profile file, later runs load it from IMAGE_PROCESSOR_PROFILE or ./image_processor.profile\n"
+           "Options (before path to input file):\n"
+           "\t--numa: pin worker threads to cpus node by node and allocate every band of rows on the node of its "
+           "worker\n"
+           "\t--numa-bench (instead of all other arguments): compare speed and memory locality with and without "
+           "--numa\n"
+           "\t--incremental <path to cache directory>: keep the result of every filter in the cache directory and "
+           "on the next run with the same filters recompute only the parts of the photo that changed";
+}
+
+// Normal runs use the profile saved by --tune if there is one and default kernels otherwise
+void LoadProfile(const std::string& profile_file) {
+    if (std::ifstream(profile_file).is_open()) {
+        Profile::Active().Read(profile_file);
+    }
 }
 
 void ApplyFilters(BMP& image, Parser& parser) {
@@ -42,9 +70,25 @@ int main(int argc, char* argv[]) {
     try {
         Parser parser = Parser(argc, argv);
         parser.ParseArgs();
+        if (parser.tune) {
+            Profile profile = Tuner(std::cout).Run();
+            profile.Write(parser.profile_file);
+            std::cout << "Profile saved to " << parser.profile_file << std::endl;
+            return 0;
+        }
+        LoadProfile(parser.profile_file);
+        if (parser.numa_bench) {
+            NumaBench(std::cout).Run();
+            return 0;
+        }
+        Numa::enabled = parser.numa;
         BMP image;
         image.Read(parser.input_file);
-        ApplyFilters(image, parser);
+        if (parser.cache_dir.empty()) {
+            ApplyFilters(image, parser);
+        } else {
+            Incremental(parser.cache_dir, parser.chain).Run(image, parser.using_filters);
+        }
         image.Write(parser.output_file);
     } catch (std::invalid_argument& e) {
         PrintException(e);